@@ -4,6 +4,7 @@
 #include <aliceVision/mvsData/Color.hpp>
 #include <aliceVision/mvsData/Rgb.hpp>
 #include <aliceVision/mvsData/Image.hpp>
+#include <aliceVision/mvsData/imageSimd.hpp>
 
 
 #include <OpenImageIO/imageio.h>
@@ -12,6 +13,8 @@
 
 #include <Eigen/Eigen>
 
+#include <stdexcept>
+
 namespace aliceVision
 {
 namespace imageAlgo
@@ -186,14 +189,14 @@ void transposeImage(oiio::TypeDesc typeDesc,
                     int nchannels,
                     std::vector<T>& buffer)
 {
-    oiio::ImageSpec imageSpec(width, height, nchannels, typeDesc);
-
-    oiio::ImageBuf inBuf(imageSpec, buffer.data());
-    oiio::ImageBuf transposeBuf;
-
-    oiio::ImageBufAlgo::transpose(transposeBuf, inBuf, oiio::ROI::All());
-
-    transposeBuf.get_pixels(oiio::ROI::All(), typeDesc, buffer.data());
+    // out-of-place tiled transpose into a per-thread scratch buffer, then
+    // swap: a single pass over the pixels, without any OIIO copy. The swap
+    // leaves the caller's previous storage behind for the next call, so batch
+    // loops stop allocating once the scratch has grown to the largest image.
+    static thread_local std::vector<T> scratch;
+    scratch.resize(buffer.size());
+    imageSimd::transpose(buffer.data(), scratch.data(), width, height);
+    buffer.swap(scratch);
 }
 
 void transposeImage(int width, int height, std::vector<unsigned char>& buffer)
@@ -237,6 +240,22 @@ void resizeImage(oiio::TypeDesc typeDesc,
 
     outBuffer.resize(outWidth * outHeight);
 
+    if((filter.empty() || filter == "box") && (downscale == 2 || downscale == 4) &&
+       (typeDesc == oiio::TypeDesc::UINT8 || typeDesc == oiio::TypeDesc::FLOAT))
+    {
+        // the common mipmap-style downscale reduces to a plain block average:
+        // run the dedicated kernel instead of OIIO's generic filtered resize
+        if(typeDesc == oiio::TypeDesc::UINT8)
+            imageSimd::resizeBox(reinterpret_cast<const unsigned char*>(inBuffer.data()),
+                                 reinterpret_cast<unsigned char*>(outBuffer.data()),
+                                 inWidth, inHeight, nchannels, downscale);
+        else
+            imageSimd::resizeBox(reinterpret_cast<const float*>(inBuffer.data()),
+                                 reinterpret_cast<float*>(outBuffer.data()),
+                                 inWidth, inHeight, nchannels, downscale);
+        return;
+    }
+
     const oiio::ImageBuf inBuf(oiio::ImageSpec(inWidth, inHeight, nchannels, typeDesc), const_cast<T*>(inBuffer.data()));
     oiio::ImageBuf outBuf(oiio::ImageSpec(outWidth, outHeight, nchannels, typeDesc), outBuffer.data());
 
@@ -270,6 +289,59 @@ void resizeImage(int downscale, const Image &inImage, Image &outImage, const std
     outImage.setWidth(inImage.width() / downscale);
 }
 
+namespace {
+
+/// Dispatch the separable convolution on the buffer format.
+void separableConvolve(oiio::TypeDesc typeDesc, const void* in, void* out,
+                       int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel)
+{
+    if(nchannels == 3)
+    {
+        // stage the interleaved pixels as one float plane per channel: the 1-D
+        // passes then run with unit stride and no lane shuffles
+        const std::size_t pixelCount = std::size_t(width) * height;
+        static thread_local imageSimd::PlanarImage planes;   // persistent across calls
+        static thread_local imageSimd::PlanarImage filtered; // ditto
+
+        if(typeDesc.basetype == oiio::TypeDesc::UINT8)
+            imageSimd::deinterleave(static_cast<const rgb*>(in), pixelCount, planes);
+        else if(typeDesc.basetype == oiio::TypeDesc::FLOAT)
+            imageSimd::deinterleave(static_cast<const Color*>(in), pixelCount, planes);
+        else
+            throw std::runtime_error("Unsupported format for separable convolution.");
+
+        // each plane is convolved into its output plane (the strip-fused
+        // passes forbid aliasing)
+        filtered.resize(pixelCount);
+        imageSimd::separableConvolve(planes.r.data(), filtered.r.data(), width, height, 1, hKernel, vKernel);
+        imageSimd::separableConvolve(planes.g.data(), filtered.g.data(), width, height, 1, hKernel, vKernel);
+        imageSimd::separableConvolve(planes.b.data(), filtered.b.data(), width, height, 1, hKernel, vKernel);
+
+        if(typeDesc.basetype == oiio::TypeDesc::UINT8)
+            imageSimd::interleave(filtered, pixelCount, static_cast<rgb*>(out));
+        else
+            imageSimd::interleave(filtered, pixelCount, static_cast<Color*>(out));
+        return;
+    }
+
+    switch(typeDesc.basetype)
+    {
+        case oiio::TypeDesc::UINT8:
+            imageSimd::separableConvolve(static_cast<const unsigned char*>(in), static_cast<unsigned char*>(out),
+                                         width, height, nchannels, hKernel, vKernel);
+            break;
+        case oiio::TypeDesc::FLOAT:
+            imageSimd::separableConvolve(static_cast<const float*>(in), static_cast<float*>(out),
+                                         width, height, nchannels, hKernel, vKernel);
+            break;
+        default:
+            throw std::runtime_error("Unsupported format for separable convolution.");
+    }
+}
+
+} // namespace
+
 template<typename T>
 void convolveImage(oiio::TypeDesc typeDesc,
                    int inWidth,
@@ -283,6 +355,17 @@ void convolveImage(oiio::TypeDesc typeDesc,
 {
     outBuffer.resize(inBuffer.size());
 
+    if(kernel == "gaussian" &&
+       (typeDesc == oiio::TypeDesc::UINT8 || typeDesc == oiio::TypeDesc::FLOAT))
+    {
+        // the gaussian kernel is separable: run two 1-D passes instead of the
+        // general 2-D convolution (O(2k) taps per pixel instead of O(k^2))
+        const std::vector<float> hKernel = imageSimd::gaussianKernel1D(kernelWidth);
+        const std::vector<float> vKernel = imageSimd::gaussianKernel1D(kernelHeight);
+        separableConvolve(typeDesc, inBuffer.data(), outBuffer.data(), inWidth, inHeight, nchannels, hKernel, vKernel);
+        return;
+    }
+
     const oiio::ImageBuf inBuf(oiio::ImageSpec(inWidth, inHeight, nchannels, typeDesc), const_cast<T*>(inBuffer.data()));
     oiio::ImageBuf outBuf(oiio::ImageSpec(inWidth, inHeight, nchannels, typeDesc), outBuffer.data());
 
@@ -55,6 +55,13 @@ void transposeImage(Image& image);
 
 /**
  * @brief resize a given image buffer
+ *
+ * Note: resize and convolution run on the CPU (SIMD + OpenMP) on purpose.
+ * mvsData is a base library also used by CUDA-less builds, so no GPU path is
+ * provided here; pipelines that batch these operations on the GPU keep their
+ * buffers device-resident in depthMap/cuda instead (see the gaussian pyramid
+ * handling in planeSweeping/plane_sweeping_cuda.cu).
+ *
  * @param[in] inWidth The input image buffer width
  * @param[in] inHeight The input image buffer height
  * @param[in] downscale The resize downscale
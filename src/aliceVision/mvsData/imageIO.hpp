@@ -195,6 +195,18 @@ void readImage(const std::string& path, int& width, int& height, std::vector<flo
 void readImage(const std::string& path, int& width, int& height, std::vector<Color>& buffer, EImageColorSpace toColorSpace);
 void readImage(const std::string& path, Image& image, EImageColorSpace toColorSpace);
 
+/**
+ * @brief read a batch of images, keeping a few decodes in flight so that the
+ * decode of the next images overlaps the conversion of the current one
+ * @param[in] paths The given paths to the images
+ * @param[out] widths The output image widths, one per path
+ * @param[out] heights The output image heights, one per path
+ * @param[out] buffers The output image buffers, one per path
+ * @param[in] toColorSpace image color space
+ */
+void readImages(const std::vector<std::string>& paths, std::vector<int>& widths, std::vector<int>& heights, std::vector<std::vector<float>>& buffers, EImageColorSpace toColorSpace);
+void readImages(const std::vector<std::string>& paths, std::vector<int>& widths, std::vector<int>& heights, std::vector<std::vector<Color>>& buffers, EImageColorSpace toColorSpace);
+
 /**
  * @brief write an image with a given path and buffer
  * @param[in] path The given path to the image
@@ -0,0 +1,1297 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include "imageSimd.hpp"
+
+#include <aliceVision/config.hpp>
+#include <aliceVision/mvsData/Color.hpp>
+#include <aliceVision/mvsData/Rgb.hpp>
+
+#if ALICEVISION_IS_DEFINED(ALICEVISION_HAVE_SSE) && defined(__AVX2__) && defined(__FMA__)
+#define ALICEVISION_IMAGESIMD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+
+// The kernels in this file are compiled twice: once with the project's
+// baseline flags (this translation unit, namespace isaScalar) and once from
+// imageSimdAVX2.cpp with -mavx2 -mfma -mf16c (namespace isaAVX2). The
+// dispatchers at the end of the file select the variant matching the
+// executing CPU, once, at first use.
+#ifdef ALICEVISION_IMAGESIMD_BUILD_AVX2
+#define ALICEVISION_IMAGESIMD_ISA isaAVX2
+#else
+#define ALICEVISION_IMAGESIMD_ISA isaScalar
+#endif
+
+namespace aliceVision {
+namespace imageSimd {
+namespace ALICEVISION_IMAGESIMD_ISA {
+
+namespace {
+
+// Rec709 luminance weights (linear scale)
+const float kLumaR = .2126f;
+const float kLumaG = .7152f;
+const float kLumaB = .0722f;
+
+inline float lumaOf(const float* pixel)
+{
+    return pixel[0] * kLumaR + pixel[1] * kLumaG + pixel[2] * kLumaB;
+}
+
+inline void storeLuma(float* out, float v)
+{
+    *out = v;
+}
+
+inline void storeLuma(unsigned char* out, float v)
+{
+    // clamp the scaled value in float first: lround of a value outside the
+    // long range (e.g. inf) is undefined
+    const float scaled = std::min(v * 255.0f, 255.0f);
+    *out = static_cast<unsigned char>(std::max(std::lround(scaled), 0L));
+}
+
+inline void storeLuma(unsigned short* out, float v)
+{
+    const float scaled = std::min(v * 65535.0f, 65535.0f);
+    *out = static_cast<unsigned short>(std::max(std::lround(scaled), 0L));
+}
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+
+/// Deinterleave 8 RGB pixels (24 contiguous floats) into one register per channel.
+inline void deinterleave8RGB(const float* p, __m256& r, __m256& g, __m256& b)
+{
+    // load lower/upper halves of the 3 pixel registers
+    __m256 m03 = _mm256_castps128_ps256(_mm_loadu_ps(p));
+    __m256 m14 = _mm256_castps128_ps256(_mm_loadu_ps(p + 4));
+    __m256 m25 = _mm256_castps128_ps256(_mm_loadu_ps(p + 8));
+    m03 = _mm256_insertf128_ps(m03, _mm_loadu_ps(p + 12), 1);
+    m14 = _mm256_insertf128_ps(m14, _mm_loadu_ps(p + 16), 1);
+    m25 = _mm256_insertf128_ps(m25, _mm_loadu_ps(p + 20), 1);
+
+    // AoS to SoA shuffle cascade
+    const __m256 rg = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2));
+    const __m256 gb = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1));
+    r = _mm256_shuffle_ps(m03, rg, _MM_SHUFFLE(2, 0, 3, 0));
+    g = _mm256_shuffle_ps(gb, rg, _MM_SHUFFLE(3, 1, 2, 0));
+    b = _mm256_shuffle_ps(gb, m25, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+/// Re-interleave one register per channel into 8 RGB pixels (24 contiguous floats).
+inline void interleave8RGB(__m256 r, __m256 g, __m256 b, float* p)
+{
+    // place each channel's lanes at its interleaved positions, then blend
+    const __m256 r0 = _mm256_permutevar8x32_ps(r, _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2));
+    const __m256 g0 = _mm256_permutevar8x32_ps(g, _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2));
+    const __m256 b0 = _mm256_permutevar8x32_ps(b, _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2));
+    _mm256_storeu_ps(p, _mm256_blend_ps(_mm256_blend_ps(r0, g0, 0x92), b0, 0x24));
+
+    const __m256 r1 = _mm256_permutevar8x32_ps(r, _mm256_setr_epi32(3, 3, 3, 4, 4, 4, 5, 5));
+    const __m256 g1 = _mm256_permutevar8x32_ps(g, _mm256_setr_epi32(3, 3, 3, 4, 4, 4, 5, 5));
+    const __m256 b1 = _mm256_permutevar8x32_ps(b, _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5));
+    _mm256_storeu_ps(p + 8, _mm256_blend_ps(_mm256_blend_ps(b1, r1, 0x92), g1, 0x24));
+
+    const __m256 r2 = _mm256_permutevar8x32_ps(r, _mm256_setr_epi32(6, 6, 6, 6, 6, 7, 7, 7));
+    const __m256 g2 = _mm256_permutevar8x32_ps(g, _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7));
+    const __m256 b2 = _mm256_permutevar8x32_ps(b, _mm256_setr_epi32(5, 5, 5, 6, 6, 6, 7, 7));
+    _mm256_storeu_ps(p + 16, _mm256_blend_ps(_mm256_blend_ps(g2, b2, 0x92), r2, 0x24));
+}
+
+/// Deinterleave 8 RGB pixels (24 contiguous floats) and return their luminance.
+inline __m256 luma8FromRGB(const float* p)
+{
+    __m256 r, g, b;
+    deinterleave8RGB(p, r, g, b);
+
+    return _mm256_fmadd_ps(r, _mm256_set1_ps(kLumaR),
+           _mm256_fmadd_ps(g, _mm256_set1_ps(kLumaG),
+                           _mm256_mul_ps(b, _mm256_set1_ps(kLumaB))));
+}
+
+/// Return the luminance of 8 RGBA pixels (32 contiguous floats), ignoring alpha.
+inline __m256 luma8FromRGBA(const float* p)
+{
+    const __m256 weights = _mm256_setr_ps(kLumaR, kLumaG, kLumaB, 0.f, kLumaR, kLumaG, kLumaB, 0.f);
+
+    const __m256 p01 = _mm256_mul_ps(_mm256_loadu_ps(p), weights);
+    const __m256 p23 = _mm256_mul_ps(_mm256_loadu_ps(p + 8), weights);
+    const __m256 p45 = _mm256_mul_ps(_mm256_loadu_ps(p + 16), weights);
+    const __m256 p67 = _mm256_mul_ps(_mm256_loadu_ps(p + 24), weights);
+
+    // pairwise reduction, then reorder the interleaved lanes
+    const __m256 s0123 = _mm256_hadd_ps(p01, p23); // l0 l2 | l1 l3 (still split in pairs)
+    const __m256 s4567 = _mm256_hadd_ps(p45, p67);
+    const __m256 luma = _mm256_hadd_ps(s0123, s4567); // l0 l2 l4 l6 | l1 l3 l5 l7
+    return _mm256_permutevar8x32_ps(luma, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+inline void storeLuma8(float* out, __m256 luma)
+{
+    _mm256_storeu_ps(out, luma);
+}
+
+inline void storeLuma8(unsigned char* out, __m256 luma)
+{
+    // clamp the high side in float first: cvtps of a value beyond the int32
+    // range yields INT32_MIN, which the packs would collapse to 0 instead of
+    // full scale (the packs themselves handle the low side)
+    const __m256 scaled = _mm256_min_ps(_mm256_set1_ps(255.0f), _mm256_mul_ps(luma, _mm256_set1_ps(255.0f)));
+    const __m256i i32 = _mm256_cvtps_epi32(scaled);
+    const __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(i32), _mm256_extracti128_si256(i32, 1));
+    const __m128i i8 = _mm_packus_epi16(i16, i16); // saturation clamps to [0;255]
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), i8);
+}
+
+inline void storeLuma8(unsigned short* out, __m256 luma)
+{
+    const __m256 scaled = _mm256_min_ps(_mm256_set1_ps(65535.0f), _mm256_mul_ps(luma, _mm256_set1_ps(65535.0f)));
+    const __m256i i32 = _mm256_cvtps_epi32(scaled);
+    const __m128i i16 = _mm_packus_epi32(_mm256_castsi256_si128(i32), _mm256_extracti128_si256(i32, 1));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), i16);
+}
+
+/// Broadcast 8 float lumas (in 0..1) to 8 interleaved RGB float pixels.
+inline void broadcastRGB8(const float* in, float* out)
+{
+    const __m256 luma = _mm256_loadu_ps(in);
+    _mm256_storeu_ps(out,      _mm256_permutevar8x32_ps(luma, _mm256_setr_epi32(0, 0, 0, 1, 1, 1, 2, 2)));
+    _mm256_storeu_ps(out + 8,  _mm256_permutevar8x32_ps(luma, _mm256_setr_epi32(2, 3, 3, 3, 4, 4, 4, 5)));
+    _mm256_storeu_ps(out + 16, _mm256_permutevar8x32_ps(luma, _mm256_setr_epi32(5, 5, 6, 6, 6, 7, 7, 7)));
+}
+
+/// Broadcast 16 float lumas to 16 interleaved RGB 8-bit pixels.
+inline void broadcastRGB16(const float* in, unsigned char* out)
+{
+    // clamp the high side in float first, like storeLuma8: cvtps of an
+    // out-of-range value yields INT32_MIN, which the packs collapse to 0
+    const __m256 limit = _mm256_set1_ps(255.0f);
+    const __m256i lo = _mm256_cvtps_epi32(_mm256_min_ps(limit, _mm256_mul_ps(_mm256_loadu_ps(in), limit)));
+    const __m256i hi = _mm256_cvtps_epi32(_mm256_min_ps(limit, _mm256_mul_ps(_mm256_loadu_ps(in + 8), limit)));
+    const __m128i i16lo = _mm_packs_epi32(_mm256_castsi256_si128(lo), _mm256_extracti128_si256(lo, 1));
+    const __m128i i16hi = _mm_packs_epi32(_mm256_castsi256_si128(hi), _mm256_extracti128_si256(hi, 1));
+    const __m128i luma = _mm_packus_epi16(i16lo, i16hi); // 16 saturated bytes
+
+    // expand each byte 3 times to fill 48 output bytes
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                     _mm_shuffle_epi8(luma, _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16),
+                     _mm_shuffle_epi8(luma, _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10)));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32),
+                     _mm_shuffle_epi8(luma, _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15)));
+}
+
+/// In-register transpose of a 8x8 float tile.
+inline void transposeTile8x8(const float* in, int inStride, float* out, int outStride)
+{
+    const __m256 r0 = _mm256_loadu_ps(in + 0 * inStride);
+    const __m256 r1 = _mm256_loadu_ps(in + 1 * inStride);
+    const __m256 r2 = _mm256_loadu_ps(in + 2 * inStride);
+    const __m256 r3 = _mm256_loadu_ps(in + 3 * inStride);
+    const __m256 r4 = _mm256_loadu_ps(in + 4 * inStride);
+    const __m256 r5 = _mm256_loadu_ps(in + 5 * inStride);
+    const __m256 r6 = _mm256_loadu_ps(in + 6 * inStride);
+    const __m256 r7 = _mm256_loadu_ps(in + 7 * inStride);
+
+    const __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    const __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    const __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    const __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    const __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    const __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    const __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    const __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+
+    const __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    const __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    const __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+
+    _mm256_storeu_ps(out + 0 * outStride, _mm256_permute2f128_ps(s0, s4, 0x20));
+    _mm256_storeu_ps(out + 1 * outStride, _mm256_permute2f128_ps(s1, s5, 0x20));
+    _mm256_storeu_ps(out + 2 * outStride, _mm256_permute2f128_ps(s2, s6, 0x20));
+    _mm256_storeu_ps(out + 3 * outStride, _mm256_permute2f128_ps(s3, s7, 0x20));
+    _mm256_storeu_ps(out + 4 * outStride, _mm256_permute2f128_ps(s0, s4, 0x31));
+    _mm256_storeu_ps(out + 5 * outStride, _mm256_permute2f128_ps(s1, s5, 0x31));
+    _mm256_storeu_ps(out + 6 * outStride, _mm256_permute2f128_ps(s2, s6, 0x31));
+    _mm256_storeu_ps(out + 7 * outStride, _mm256_permute2f128_ps(s3, s7, 0x31));
+}
+
+/// In-register transpose of a 16x16 8-bit tile (byte/word/dword/qword unpack cascade).
+inline void transposeTile16x16(const unsigned char* in, int inStride, unsigned char* out, int outStride)
+{
+    __m128i r[16], t[16], u[16];
+
+    for(int i = 0; i < 16; ++i)
+        r[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i * inStride));
+
+    for(int i = 0; i < 8; ++i)
+    {
+        t[2 * i] = _mm_unpacklo_epi8(r[2 * i], r[2 * i + 1]);
+        t[2 * i + 1] = _mm_unpackhi_epi8(r[2 * i], r[2 * i + 1]);
+    }
+    for(int i = 0; i < 4; ++i)
+    {
+        u[4 * i] = _mm_unpacklo_epi16(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 1] = _mm_unpackhi_epi16(t[4 * i], t[4 * i + 2]);
+        u[4 * i + 2] = _mm_unpacklo_epi16(t[4 * i + 1], t[4 * i + 3]);
+        u[4 * i + 3] = _mm_unpackhi_epi16(t[4 * i + 1], t[4 * i + 3]);
+    }
+    for(int i = 0; i < 2; ++i)
+    {
+        t[8 * i] = _mm_unpacklo_epi32(u[8 * i], u[8 * i + 4]);
+        t[8 * i + 1] = _mm_unpackhi_epi32(u[8 * i], u[8 * i + 4]);
+        t[8 * i + 2] = _mm_unpacklo_epi32(u[8 * i + 1], u[8 * i + 5]);
+        t[8 * i + 3] = _mm_unpackhi_epi32(u[8 * i + 1], u[8 * i + 5]);
+        t[8 * i + 4] = _mm_unpacklo_epi32(u[8 * i + 2], u[8 * i + 6]);
+        t[8 * i + 5] = _mm_unpackhi_epi32(u[8 * i + 2], u[8 * i + 6]);
+        t[8 * i + 6] = _mm_unpacklo_epi32(u[8 * i + 3], u[8 * i + 7]);
+        t[8 * i + 7] = _mm_unpackhi_epi32(u[8 * i + 3], u[8 * i + 7]);
+    }
+    for(int i = 0; i < 8; ++i)
+    {
+        u[2 * i] = _mm_unpacklo_epi64(t[i], t[i + 8]);
+        u[2 * i + 1] = _mm_unpackhi_epi64(t[i], t[i + 8]);
+    }
+
+    // output row i now holds input column i
+    for(int i = 0; i < 16; ++i)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * outStride), u[i]);
+}
+
+#endif // ALICEVISION_IMAGESIMD_AVX2
+
+inline void storeSample(float* out, float v)
+{
+    *out = v;
+}
+
+inline void storeSample(unsigned char* out, float v)
+{
+    *out = static_cast<unsigned char>(std::min(std::max(std::lround(v), 0L), 255L));
+}
+
+/// Raw binary16 scratch sample (bit pattern): used between the two convolution
+/// passes to halve the bytes touched when the output precision permits.
+struct HalfSample
+{
+    unsigned short bits;
+};
+
+inline float sampleToFloat(float v)
+{
+    return v;
+}
+
+inline float sampleToFloat(unsigned char v)
+{
+    return float(v);
+}
+
+unsigned short floatToHalfScalar(float f);
+float halfToFloatScalar(unsigned short h);
+
+inline float sampleToFloat(HalfSample v)
+{
+    return halfToFloatScalar(v.bits);
+}
+
+inline void storeScratch(float* out, float v)
+{
+    *out = v;
+}
+
+inline void storeScratch(HalfSample* out, float v)
+{
+    out->bits = floatToHalfScalar(v);
+}
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+
+inline __m256 loadSamples8(const float* in)
+{
+    return _mm256_loadu_ps(in);
+}
+
+inline __m256 loadSamples8(const unsigned char* in)
+{
+    return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(in))));
+}
+
+inline void storeSamples8(float* out, __m256 v)
+{
+    _mm256_storeu_ps(out, v);
+}
+
+inline void storeSamples8(unsigned char* out, __m256 v)
+{
+    const __m256i i32 = _mm256_cvtps_epi32(v);
+    const __m128i i16 = _mm_packs_epi32(_mm256_castsi256_si128(i32), _mm256_extracti128_si256(i32, 1));
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(i16, i16));
+}
+
+inline void storeScratch8(float* out, __m256 v)
+{
+    _mm256_storeu_ps(out, v);
+}
+
+#ifdef __F16C__
+
+inline __m256 loadSamples8(const HalfSample* in)
+{
+    return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+}
+
+inline void storeScratch8(HalfSample* out, __m256 v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+#endif // __F16C__
+
+#endif // ALICEVISION_IMAGESIMD_AVX2
+
+/// Scratch sample type for the 8-bit convolution pipeline: binary16 when the
+/// F16C converters keep the load/store boundaries cheap, float otherwise. The
+/// float pipeline always keeps a float scratch to preserve its precision.
+#if defined(ALICEVISION_IMAGESIMD_AVX2) && defined(__F16C__)
+typedef HalfSample ByteScratchSample;
+#else
+typedef float ByteScratchSample;
+#endif
+
+/// Convolve one sample against the horizontal taps, with bounds checks (samples
+/// outside the row are black).
+template<typename InT>
+inline float convolveSampleBounded(const InT* row, int rowSamples, int nchannels, int s,
+                                   const std::vector<float>& taps, int radius)
+{
+    float sum = 0.f;
+    for(int i = 0; i < int(taps.size()); ++i)
+    {
+        const int ss = s + (i - radius) * nchannels;
+        if(ss >= 0 && ss < rowSamples)
+            sum += taps[i] * float(row[ss]);
+    }
+    return sum;
+}
+
+/// Horizontal convolution pass over image rows [rowBegin;rowEnd), into a
+/// scratch buffer (float, or binary16 for the 8-bit pipeline) whose first row
+/// corresponds to @p rowBegin.
+template<typename InT, typename ScratchT>
+void convolveRowsRange(const InT* in, ScratchT* scratch, int width, int nchannels,
+                       const std::vector<float>& taps, int rowBegin, int rowEnd)
+{
+    const int tapCount = int(taps.size());
+    const int radius = tapCount / 2;
+    const int rowSamples = width * nchannels;
+    const int interBegin = std::min(radius * nchannels, rowSamples);
+    const int interEnd = std::max(rowSamples - radius * nchannels, interBegin);
+
+    for(int y = rowBegin; y < rowEnd; ++y)
+    {
+        const InT* srcRow = in + std::size_t(y) * rowSamples;
+        ScratchT* dstRow = scratch + std::size_t(y - rowBegin) * rowSamples;
+
+        for(int s = 0; s < interBegin; ++s)
+            storeScratch(dstRow + s, convolveSampleBounded(srcRow, rowSamples, nchannels, s, taps, radius));
+
+        int s = interBegin;
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+        for(; s + 8 <= interEnd; s += 8)
+        {
+            __m256 acc = _mm256_setzero_ps();
+            for(int i = 0; i < tapCount; ++i)
+                acc = _mm256_fmadd_ps(_mm256_set1_ps(taps[i]),
+                                      loadSamples8(srcRow + s + (i - radius) * nchannels), acc);
+            storeScratch8(dstRow + s, acc);
+        }
+#endif
+        for(; s < interEnd; ++s)
+        {
+            float sum = 0.f;
+            for(int i = 0; i < tapCount; ++i)
+                sum += taps[i] * float(srcRow[s + (i - radius) * nchannels]);
+            storeScratch(dstRow + s, sum);
+        }
+
+        for(s = interEnd; s < rowSamples; ++s)
+            storeScratch(dstRow + s, convolveSampleBounded(srcRow, rowSamples, nchannels, s, taps, radius));
+    }
+}
+
+/// Vertical convolution pass producing output rows [yBegin;yEnd) from a
+/// scratch buffer whose first row corresponds to image row @p scratchBegin.
+template<typename ScratchT, typename OutT>
+void convolveColumnsRange(const ScratchT* scratch, OutT* out, int width, int height, int nchannels,
+                          const std::vector<float>& taps, int yBegin, int yEnd, int scratchBegin)
+{
+    const int tapCount = int(taps.size());
+    const int radius = tapCount / 2;
+    const int rowSamples = width * nchannels;
+
+    for(int y = yBegin; y < yEnd; ++y)
+    {
+        // taps hitting rows outside the image contribute black
+        const int jBegin = std::max(0, radius - y);
+        const int jEnd = std::min(tapCount, height - y + radius);
+        const int prefetchRow = y + radius + 1 - scratchBegin; // first scratch row the next output row adds
+        OutT* dstRow = out + std::size_t(y) * rowSamples;
+
+        int s = 0;
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+        for(; s + 8 <= rowSamples; s += 8)
+        {
+            // the next output row of this strip reads one new scratch row; its
+            // large stride from the current reads defeats the hardware prefetcher
+            if(y + 1 < yEnd && y + radius + 1 < height)
+                _mm_prefetch(reinterpret_cast<const char*>(scratch + std::size_t(prefetchRow) * rowSamples + s), _MM_HINT_T0);
+
+            __m256 acc = _mm256_setzero_ps();
+            for(int j = jBegin; j < jEnd; ++j)
+                acc = _mm256_fmadd_ps(_mm256_set1_ps(taps[j]),
+                                      loadSamples8(scratch + std::size_t(y + j - radius - scratchBegin) * rowSamples + s), acc);
+            storeSamples8(dstRow + s, acc);
+        }
+#endif
+        for(; s < rowSamples; ++s)
+        {
+            float sum = 0.f;
+            for(int j = jBegin; j < jEnd; ++j)
+                sum += taps[j] * sampleToFloat(scratch[std::size_t(y + j - radius - scratchBegin) * rowSamples + s]);
+            storeSample(dstRow + s, sum);
+        }
+    }
+}
+
+/// Height of the fused strips: a strip plus its vertical apron must stay L2
+/// resident between the two passes.
+const int kConvolveStrip = 64;
+
+/// Fused strip execution of the two passes: the horizontal result for a strip
+/// of rows is consumed by the vertical pass while still cache resident,
+/// instead of round-tripping the whole intermediate image through memory.
+/// The 2 * radius apron rows recomputed per strip are far cheaper than that
+/// round-trip.
+template<typename ScratchT, typename InT, typename OutT>
+void separableConvolveImpl(const InT* in, OutT* out, int width, int height, int nchannels,
+                           const std::vector<float>& hKernel, const std::vector<float>& vKernel)
+{
+    const int vRadius = int(vKernel.size()) / 2;
+    const int rowSamples = width * nchannels;
+    const int stripCount = (height + kConvolveStrip - 1) / kConvolveStrip;
+
+    #pragma omp parallel for schedule(static) if(stripCount > 1)
+    for(int strip = 0; strip < stripCount; ++strip)
+    {
+        const int yBegin = strip * kConvolveStrip;
+        const int yEnd = std::min(yBegin + kConvolveStrip, height);
+        const int srcBegin = std::max(0, yBegin - vRadius);
+        const int srcEnd = std::min(height, yEnd + vRadius);
+
+        // per-thread persistent strip scratch (strip height + apron rows)
+        static thread_local std::vector<ScratchT, DefaultInitAllocator<ScratchT>> scratch;
+        const std::size_t sampleCount = std::size_t(srcEnd - srcBegin) * rowSamples;
+        if(scratch.size() < sampleCount)
+            scratch.resize(sampleCount);
+
+        convolveRowsRange(in, scratch.data(), width, nchannels, hKernel, srcBegin, srcEnd);
+        convolveColumnsRange(scratch.data(), out, width, height, nchannels, vKernel, yBegin, yEnd, srcBegin);
+    }
+}
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+
+/// Sum 8 horizontal pairs (16 contiguous samples) into memory order.
+template<typename InT>
+inline __m256 hsumPairs8(const InT* in)
+{
+    const __m256 h = _mm256_hadd_ps(loadSamples8(in), loadSamples8(in + 8));
+    // hadd interleaves the two sources per 128-bit lane; restore memory order
+    return _mm256_permutevar8x32_ps(h, _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7));
+}
+
+/// Sum 8 horizontal quads (32 contiguous samples) into memory order.
+template<typename InT>
+inline __m256 hsumQuads8(const InT* in)
+{
+    const __m256 h = _mm256_hadd_ps(_mm256_hadd_ps(loadSamples8(in), loadSamples8(in + 8)),
+                                    _mm256_hadd_ps(loadSamples8(in + 16), loadSamples8(in + 24)));
+    return _mm256_permutevar8x32_ps(h, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+#endif // ALICEVISION_IMAGESIMD_AVX2
+
+template<typename T>
+void resizeBoxImpl(const T* in, T* out, int width, int height, int nchannels, int factor)
+{
+    const int outWidth = width / factor;
+    const int outHeight = height / factor;
+    const int rowSamples = width * nchannels;
+    const int outRowSamples = outWidth * nchannels;
+    const float scale = 1.f / float(factor * factor);
+
+    #pragma omp parallel for schedule(static) if(outHeight > 64)
+    for(int y = 0; y < outHeight; ++y)
+    {
+        const T* srcRows = in + std::size_t(y) * factor * rowSamples;
+        T* dstRow = out + std::size_t(y) * outRowSamples;
+
+        int x = 0;
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+        if(nchannels == 1 && (factor == 2 || factor == 4))
+        {
+            const __m256 vscale = _mm256_set1_ps(scale);
+            for(; x + 8 <= outWidth; x += 8)
+            {
+                __m256 acc = _mm256_setzero_ps();
+                for(int dy = 0; dy < factor; ++dy)
+                {
+                    const T* srcRow = srcRows + std::size_t(dy) * rowSamples + x * factor;
+                    acc = _mm256_add_ps(acc, (factor == 2) ? hsumPairs8(srcRow) : hsumQuads8(srcRow));
+                }
+                storeSamples8(dstRow + x, _mm256_mul_ps(acc, vscale));
+            }
+        }
+#endif
+        for(; x < outWidth; ++x)
+        {
+            for(int c = 0; c < nchannels; ++c)
+            {
+                float sum = 0.f;
+                for(int dy = 0; dy < factor; ++dy)
+                    for(int dx = 0; dx < factor; ++dx)
+                        sum += float(srcRows[std::size_t(dy) * rowSamples + (x * factor + dx) * nchannels + c]);
+                storeSample(dstRow + x * nchannels + c, sum * scale);
+            }
+        }
+    }
+}
+
+/// Scalar float to binary16 conversion, round to nearest even (same result as
+/// the F16C vcvtps2ph instruction).
+inline unsigned short floatToHalfScalar(float f)
+{
+    union { float f; unsigned int u; } v;
+    v.f = f;
+
+    const unsigned short sign = (v.u >> 16) & 0x8000u;
+    const unsigned int biasedExp = (v.u >> 23) & 0xffu;
+    unsigned int mant = v.u & 0x7fffffu;
+
+    if(biasedExp == 255u) // inf / nan
+        return sign | 0x7c00u | (mant ? 0x200u | (mant >> 13) : 0u);
+
+    const int exp = int(biasedExp) - 127 + 15;
+    if(exp >= 31) // overflow to inf
+        return sign | 0x7c00u;
+
+    if(exp <= 0) // subnormal or zero
+    {
+        if(exp < -10)
+            return sign;
+        mant |= 0x800000u; // implicit leading bit
+        const unsigned int shift = 14 - exp;
+        unsigned short h = static_cast<unsigned short>(mant >> shift);
+        const unsigned int rem = mant & ((1u << shift) - 1u);
+        const unsigned int halfway = 1u << (shift - 1);
+        if(rem > halfway || (rem == halfway && (h & 1u)))
+            ++h;
+        return sign | h;
+    }
+
+    unsigned short h = static_cast<unsigned short>((exp << 10) | (mant >> 13));
+    const unsigned int rem = mant & 0x1fffu;
+    // round to nearest even; a carry correctly propagates into the exponent
+    if(rem > 0x1000u || (rem == 0x1000u && (h & 1u)))
+        ++h;
+    return sign | h;
+}
+
+/// Scalar binary16 to float conversion (exact).
+inline float halfToFloatScalar(unsigned short h)
+{
+    const unsigned int sign = (unsigned int)(h & 0x8000u) << 16;
+    const unsigned int exp = (h >> 10) & 0x1fu;
+    unsigned int mant = h & 0x3ffu;
+
+    union { unsigned int u; float f; } v;
+    if(exp == 0)
+    {
+        if(mant == 0)
+        {
+            v.u = sign; // +-0
+        }
+        else
+        {
+            // subnormal: renormalize
+            int shift = 0;
+            while(!(mant & 0x400u))
+            {
+                mant <<= 1;
+                ++shift;
+            }
+            v.u = sign | ((127 - 15 - shift) << 23) | ((mant & 0x3ffu) << 13);
+        }
+    }
+    else if(exp == 31) // inf / nan
+    {
+        v.u = sign | 0x7f800000u | (mant << 13);
+    }
+    else
+    {
+        v.u = sign | ((exp - 15 + 127) << 23) | (mant << 13);
+    }
+    return v.f;
+}
+
+/// Cache-blocked scalar transpose, valid for any pixel type.
+template<typename T>
+void transposeBlocked(const T* in, T* out, int width, int height)
+{
+    const int tile = 32;
+
+    #pragma omp parallel for schedule(static) if(height > 64)
+    for(int y0 = 0; y0 < height; y0 += tile)
+    {
+        const int yEnd = std::min(y0 + tile, height);
+        for(int x0 = 0; x0 < width; x0 += tile)
+        {
+            const int xEnd = std::min(x0 + tile, width);
+            for(int y = y0; y < yEnd; ++y)
+                for(int x = x0; x < xEnd; ++x)
+                    out[std::size_t(x) * height + y] = in[std::size_t(y) * width + x];
+        }
+    }
+}
+
+/// Scalar broadcast loop; OutChannels > 0 monomorphizes the pixel stride so
+/// the compiler unrolls the loop body with a compile-time step.
+template<int OutChannels, typename T>
+void luminanceToRGBImpl(const float* in, std::size_t pixelCount, T* out, int outChannels)
+{
+    const int stride = (OutChannels > 0) ? OutChannels : outChannels;
+    std::size_t i = 0;
+
+    // scalar (and fallback for more than 3 channels: extra channels are zeroed,
+    // like an OIIO paste into a black image)
+    for(; i < pixelCount; ++i, out += stride)
+    {
+        storeLuma(out, in[i]);
+        out[1] = out[0];
+        out[2] = out[0];
+        for(int c = 3; c < stride; ++c)
+            out[c] = T(0);
+    }
+}
+
+/// Pixel chunk processed per task by the parallel kernel wrappers; the loops
+/// have no carried state so any split is valid.
+const std::size_t kParallelChunk = 1 << 14;
+
+/// Luminance conversion over one chunk; InChannels > 0 monomorphizes the
+/// pixel stride so the scalar loop unrolls with a compile-time step.
+template<int InChannels, typename T>
+void rgbToLuminanceChunk(const float* in, int inChannels, std::size_t pixelCount, T* out)
+{
+    const int stride = (InChannels > 0) ? InChannels : inChannels;
+    std::size_t i = 0;
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    if(stride == 3)
+    {
+        for(; i + 8 <= pixelCount; i += 8, in += 8 * 3)
+            storeLuma8(out + i, luma8FromRGB(in));
+    }
+    else if(stride == 4)
+    {
+        for(; i + 8 <= pixelCount; i += 8, in += 8 * 4)
+            storeLuma8(out + i, luma8FromRGBA(in));
+    }
+#endif
+
+    // scalar tail (and fallback for exotic channel counts)
+    for(; i < pixelCount; ++i, in += stride)
+        storeLuma(out + i, lumaOf(in));
+}
+
+template<typename T>
+void rgbToLuminanceImpl(const float* in, int inChannels, std::size_t pixelCount, T* out)
+{
+    // select the monomorphic instantiation for the common channel counts
+    void (*chunkFunc)(const float*, int, std::size_t, T*) =
+        (inChannels == 3) ? &rgbToLuminanceChunk<3, T> :
+        (inChannels == 4) ? &rgbToLuminanceChunk<4, T> :
+                            &rgbToLuminanceChunk<0, T>;
+
+    const int chunkCount = int((pixelCount + kParallelChunk - 1) / kParallelChunk);
+
+    #pragma omp parallel for schedule(static) if(chunkCount > 1)
+    for(int c = 0; c < chunkCount; ++c)
+    {
+        const std::size_t begin = std::size_t(c) * kParallelChunk;
+        chunkFunc(in + begin * inChannels, inChannels,
+                  std::min(kParallelChunk, pixelCount - begin), out + begin);
+    }
+}
+
+template<int OutChannels>
+void luminanceToRGBChunk(const float* in, std::size_t pixelCount, float* out, int outChannels)
+{
+    std::size_t i = 0;
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    if(OutChannels == 3)
+    {
+        for(; i + 8 <= pixelCount; i += 8, out += 8 * 3)
+            broadcastRGB8(in + i, out);
+    }
+#endif
+
+    luminanceToRGBImpl<OutChannels>(in + i, pixelCount - i, out, outChannels);
+}
+
+template<int OutChannels>
+void luminanceToRGBChunk(const float* in, std::size_t pixelCount, unsigned char* out, int outChannels)
+{
+    std::size_t i = 0;
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    if(OutChannels == 3)
+    {
+        for(; i + 16 <= pixelCount; i += 16, out += 16 * 3)
+            broadcastRGB16(in + i, out);
+    }
+#endif
+
+    luminanceToRGBImpl<OutChannels>(in + i, pixelCount - i, out, outChannels);
+}
+
+template<typename T>
+void luminanceToRGBParallel(const float* in, std::size_t pixelCount, T* out, int outChannels)
+{
+    // select the monomorphic instantiation for the common channel counts
+    void (*chunkFunc)(const float*, std::size_t, T*, int) = &luminanceToRGBChunk<0>;
+    if(outChannels == 3)
+        chunkFunc = &luminanceToRGBChunk<3>;
+    else if(outChannels == 4)
+        chunkFunc = &luminanceToRGBChunk<4>;
+
+    const int chunkCount = int((pixelCount + kParallelChunk - 1) / kParallelChunk);
+
+    #pragma omp parallel for schedule(static) if(chunkCount > 1)
+    for(int c = 0; c < chunkCount; ++c)
+    {
+        const std::size_t begin = std::size_t(c) * kParallelChunk;
+        chunkFunc(in + begin, std::min(kParallelChunk, pixelCount - begin),
+                  out + begin * outChannels, outChannels);
+    }
+}
+
+} // namespace
+
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, float* out)
+{
+    rgbToLuminanceImpl(in, inChannels, pixelCount, out);
+}
+
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned char* out)
+{
+    rgbToLuminanceImpl(in, inChannels, pixelCount, out);
+}
+
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned short* out)
+{
+    rgbToLuminanceImpl(in, inChannels, pixelCount, out);
+}
+
+void luminanceToRGB(const float* in, std::size_t pixelCount, float* out, int outChannels)
+{
+    luminanceToRGBParallel(in, pixelCount, out, outChannels);
+}
+
+void luminanceToRGB(const float* in, std::size_t pixelCount, unsigned char* out, int outChannels)
+{
+    luminanceToRGBParallel(in, pixelCount, out, outChannels);
+}
+
+void transpose(const unsigned char* in, unsigned char* out, int width, int height)
+{
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    const int micro = 16; // register tile
+    const int tile = 64;  // cache tile
+    const int wFull = width - width % micro;
+    const int hFull = height - height % micro;
+
+    #pragma omp parallel for schedule(static) if(hFull > 64)
+    for(int y0 = 0; y0 < hFull; y0 += tile)
+        for(int x0 = 0; x0 < wFull; x0 += tile)
+            for(int y = y0; y < std::min(y0 + tile, hFull); y += micro)
+                for(int x = x0; x < std::min(x0 + tile, wFull); x += micro)
+                {
+                    // prefetch the same tile one register tile down: its row
+                    // stride defeats the hardware prefetcher on wide images
+                    if(y + micro < hFull)
+                        for(int i = 0; i < micro; ++i)
+                            _mm_prefetch(reinterpret_cast<const char*>(in + std::size_t(y + micro + i) * width + x), _MM_HINT_T0);
+
+                    transposeTile16x16(in + std::size_t(y) * width + x, width,
+                                       out + std::size_t(x) * height + y, height);
+                }
+
+    // right and bottom borders
+    for(int y = 0; y < height; ++y)
+        for(int x = wFull; x < width; ++x)
+            out[std::size_t(x) * height + y] = in[std::size_t(y) * width + x];
+    for(int y = hFull; y < height; ++y)
+        for(int x = 0; x < wFull; ++x)
+            out[std::size_t(x) * height + y] = in[std::size_t(y) * width + x];
+#else
+    transposeBlocked(in, out, width, height);
+#endif
+}
+
+void transpose(const float* in, float* out, int width, int height)
+{
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    const int micro = 8;  // register tile
+    const int tile = 64;  // cache tile
+    const int wFull = width - width % micro;
+    const int hFull = height - height % micro;
+
+    #pragma omp parallel for schedule(static) if(hFull > 64)
+    for(int y0 = 0; y0 < hFull; y0 += tile)
+        for(int x0 = 0; x0 < wFull; x0 += tile)
+            for(int y = y0; y < std::min(y0 + tile, hFull); y += micro)
+                for(int x = x0; x < std::min(x0 + tile, wFull); x += micro)
+                {
+                    // prefetch the same tile one register tile down: its row
+                    // stride defeats the hardware prefetcher on wide images
+                    if(y + micro < hFull)
+                        for(int i = 0; i < micro; ++i)
+                            _mm_prefetch(reinterpret_cast<const char*>(in + std::size_t(y + micro + i) * width + x), _MM_HINT_T0);
+
+                    transposeTile8x8(in + std::size_t(y) * width + x, width,
+                                     out + std::size_t(x) * height + y, height);
+                }
+
+    // right and bottom borders
+    for(int y = 0; y < height; ++y)
+        for(int x = wFull; x < width; ++x)
+            out[std::size_t(x) * height + y] = in[std::size_t(y) * width + x];
+    for(int y = hFull; y < height; ++y)
+        for(int x = 0; x < wFull; ++x)
+            out[std::size_t(x) * height + y] = in[std::size_t(y) * width + x];
+#else
+    transposeBlocked(in, out, width, height);
+#endif
+}
+
+void transpose(const rgb* in, rgb* out, int width, int height)
+{
+    transposeBlocked(in, out, width, height);
+}
+
+void transpose(const Color* in, Color* out, int width, int height)
+{
+    transposeBlocked(in, out, width, height);
+}
+
+void deinterleave(const Color* in, std::size_t pixelCount, PlanarImage& planes)
+{
+    planes.resize(pixelCount);
+    const float* p = &in->r;
+    std::size_t i = 0;
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    for(; i + 8 <= pixelCount; i += 8, p += 8 * 3)
+    {
+        __m256 r, g, b;
+        deinterleave8RGB(p, r, g, b);
+        _mm256_storeu_ps(planes.r.data() + i, r);
+        _mm256_storeu_ps(planes.g.data() + i, g);
+        _mm256_storeu_ps(planes.b.data() + i, b);
+    }
+#endif
+
+    for(; i < pixelCount; ++i, p += 3)
+    {
+        planes.r[i] = p[0];
+        planes.g[i] = p[1];
+        planes.b[i] = p[2];
+    }
+}
+
+void deinterleave(const rgb* in, std::size_t pixelCount, PlanarImage& planes)
+{
+    planes.resize(pixelCount);
+    const unsigned char* p = &in->r;
+    for(std::size_t i = 0; i < pixelCount; ++i, p += 3)
+    {
+        planes.r[i] = float(p[0]);
+        planes.g[i] = float(p[1]);
+        planes.b[i] = float(p[2]);
+    }
+}
+
+void interleave(const PlanarImage& planes, std::size_t pixelCount, Color* out)
+{
+    float* p = &out->r;
+    std::size_t i = 0;
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    for(; i + 8 <= pixelCount; i += 8, p += 8 * 3)
+        interleave8RGB(_mm256_loadu_ps(planes.r.data() + i),
+                       _mm256_loadu_ps(planes.g.data() + i),
+                       _mm256_loadu_ps(planes.b.data() + i), p);
+#endif
+
+    for(; i < pixelCount; ++i, p += 3)
+    {
+        p[0] = planes.r[i];
+        p[1] = planes.g[i];
+        p[2] = planes.b[i];
+    }
+}
+
+void interleave(const PlanarImage& planes, std::size_t pixelCount, rgb* out)
+{
+    unsigned char* p = &out->r;
+    for(std::size_t i = 0; i < pixelCount; ++i, p += 3)
+    {
+        storeSample(p + 0, planes.r[i]);
+        storeSample(p + 1, planes.g[i]);
+        storeSample(p + 2, planes.b[i]);
+    }
+}
+
+void resizeBox(const float* in, float* out, int width, int height, int nchannels, int factor)
+{
+    resizeBoxImpl(in, out, width, height, nchannels, factor);
+}
+
+void resizeBox(const unsigned char* in, unsigned char* out, int width, int height, int nchannels, int factor)
+{
+    resizeBoxImpl(in, out, width, height, nchannels, factor);
+}
+
+void floatToHalf(const float* in, unsigned short* out, std::size_t count)
+{
+    // values beyond the largest finite half saturate to +-65504 instead of
+    // overflowing to inf: HDR outliers would otherwise compress badly (PIZ)
+    // and poison any downstream filtering; nan payloads pass through
+    std::size_t i = 0;
+
+#if defined(ALICEVISION_IMAGESIMD_AVX2) && defined(__F16C__)
+    const __m256 lo = _mm256_set1_ps(-65504.0f);
+    const __m256 hi = _mm256_set1_ps(65504.0f);
+    for(; i + 8 <= count; i += 8)
+    {
+        const __m256 v = _mm256_min_ps(hi, _mm256_max_ps(lo, _mm256_loadu_ps(in + i)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+                         _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        float v = in[i];
+        if(v > 65504.0f)
+            v = 65504.0f;
+        else if(v < -65504.0f)
+            v = -65504.0f;
+        out[i] = floatToHalfScalar(v);
+    }
+}
+
+void floatToByte(const float* in, unsigned char* out, std::size_t count)
+{
+    std::size_t i = 0;
+
+#ifdef ALICEVISION_IMAGESIMD_AVX2
+    // clamp the high side in float before cvtps: an out-of-range scaled value
+    // yields INT32_MIN, which the packs would collapse to 0 instead of 255
+    // (the packs themselves handle the low side)
+    const __m256 scale = _mm256_set1_ps(255.0f);
+    for(; i + 32 <= count; i += 32)
+    {
+        const __m256i a = _mm256_cvtps_epi32(_mm256_min_ps(scale, _mm256_mul_ps(_mm256_loadu_ps(in + i), scale)));
+        const __m256i b = _mm256_cvtps_epi32(_mm256_min_ps(scale, _mm256_mul_ps(_mm256_loadu_ps(in + i + 8), scale)));
+        const __m256i c = _mm256_cvtps_epi32(_mm256_min_ps(scale, _mm256_mul_ps(_mm256_loadu_ps(in + i + 16), scale)));
+        const __m256i d = _mm256_cvtps_epi32(_mm256_min_ps(scale, _mm256_mul_ps(_mm256_loadu_ps(in + i + 24), scale)));
+
+        // the packs saturate to [0;255] but interleave per 128-bit lane;
+        // restore memory order with a final dword permute
+        const __m256i packed = _mm256_packus_epi16(_mm256_packus_epi32(a, b), _mm256_packus_epi32(c, d));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_permutevar8x32_epi32(packed, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7)));
+    }
+#endif
+
+    for(; i < count; ++i)
+        storeLuma(out + i, in[i]);
+}
+
+void separableConvolve(const float* in, float* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel)
+{
+    separableConvolveImpl<float>(in, out, width, height, nchannels, hKernel, vKernel);
+}
+
+void separableConvolve(const unsigned char* in, unsigned char* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel)
+{
+    // binary16 scratch (when F16C is available): the 8-bit output hides the
+    // lower intermediate precision and the passes touch half the bytes
+    separableConvolveImpl<ByteScratchSample>(in, out, width, height, nchannels, hKernel, vKernel);
+}
+
+} // namespace ALICEVISION_IMAGESIMD_ISA
+
+#ifndef ALICEVISION_IMAGESIMD_BUILD_AVX2
+
+#ifdef ALICEVISION_IMAGESIMD_DISPATCH_AVX2
+
+// compiled from imageSimdAVX2.cpp, the -mavx2 -mfma -mf16c pass over this file
+namespace isaAVX2 {
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, float* out);
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned char* out);
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned short* out);
+void luminanceToRGB(const float* in, std::size_t pixelCount, float* out, int outChannels);
+void luminanceToRGB(const float* in, std::size_t pixelCount, unsigned char* out, int outChannels);
+void transpose(const unsigned char* in, unsigned char* out, int width, int height);
+void transpose(const float* in, float* out, int width, int height);
+void transpose(const rgb* in, rgb* out, int width, int height);
+void transpose(const Color* in, Color* out, int width, int height);
+void deinterleave(const Color* in, std::size_t pixelCount, PlanarImage& planes);
+void deinterleave(const rgb* in, std::size_t pixelCount, PlanarImage& planes);
+void interleave(const PlanarImage& planes, std::size_t pixelCount, Color* out);
+void interleave(const PlanarImage& planes, std::size_t pixelCount, rgb* out);
+void floatToHalf(const float* in, unsigned short* out, std::size_t count);
+void floatToByte(const float* in, unsigned char* out, std::size_t count);
+void separableConvolve(const float* in, float* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel);
+void separableConvolve(const unsigned char* in, unsigned char* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel);
+void resizeBox(const float* in, float* out, int width, int height, int nchannels, int factor);
+void resizeBox(const unsigned char* in, unsigned char* out, int width, int height, int nchannels, int factor);
+} // namespace isaAVX2
+
+namespace {
+
+/// One-time CPU capability check: a generic build carries both kernel passes
+/// and keeps running on CPUs without AVX2.
+bool useAVX2()
+{
+    static const bool supported = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return supported;
+}
+
+} // namespace
+
+#else // !ALICEVISION_IMAGESIMD_DISPATCH_AVX2
+
+namespace {
+
+namespace isaAVX2 = imageSimd::isaScalar;
+
+inline bool useAVX2()
+{
+    return false;
+}
+
+} // namespace
+
+#endif // ALICEVISION_IMAGESIMD_DISPATCH_AVX2
+
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, float* out)
+{
+    if(useAVX2())
+        isaAVX2::rgbToLuminance(in, inChannels, pixelCount, out);
+    else
+        isaScalar::rgbToLuminance(in, inChannels, pixelCount, out);
+}
+
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned char* out)
+{
+    if(useAVX2())
+        isaAVX2::rgbToLuminance(in, inChannels, pixelCount, out);
+    else
+        isaScalar::rgbToLuminance(in, inChannels, pixelCount, out);
+}
+
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned short* out)
+{
+    if(useAVX2())
+        isaAVX2::rgbToLuminance(in, inChannels, pixelCount, out);
+    else
+        isaScalar::rgbToLuminance(in, inChannels, pixelCount, out);
+}
+
+void luminanceToRGB(const float* in, std::size_t pixelCount, float* out, int outChannels)
+{
+    if(useAVX2())
+        isaAVX2::luminanceToRGB(in, pixelCount, out, outChannels);
+    else
+        isaScalar::luminanceToRGB(in, pixelCount, out, outChannels);
+}
+
+void luminanceToRGB(const float* in, std::size_t pixelCount, unsigned char* out, int outChannels)
+{
+    if(useAVX2())
+        isaAVX2::luminanceToRGB(in, pixelCount, out, outChannels);
+    else
+        isaScalar::luminanceToRGB(in, pixelCount, out, outChannels);
+}
+
+void transpose(const unsigned char* in, unsigned char* out, int width, int height)
+{
+    if(useAVX2())
+        isaAVX2::transpose(in, out, width, height);
+    else
+        isaScalar::transpose(in, out, width, height);
+}
+
+void transpose(const float* in, float* out, int width, int height)
+{
+    if(useAVX2())
+        isaAVX2::transpose(in, out, width, height);
+    else
+        isaScalar::transpose(in, out, width, height);
+}
+
+void transpose(const rgb* in, rgb* out, int width, int height)
+{
+    if(useAVX2())
+        isaAVX2::transpose(in, out, width, height);
+    else
+        isaScalar::transpose(in, out, width, height);
+}
+
+void transpose(const Color* in, Color* out, int width, int height)
+{
+    if(useAVX2())
+        isaAVX2::transpose(in, out, width, height);
+    else
+        isaScalar::transpose(in, out, width, height);
+}
+
+void deinterleave(const Color* in, std::size_t pixelCount, PlanarImage& planes)
+{
+    if(useAVX2())
+        isaAVX2::deinterleave(in, pixelCount, planes);
+    else
+        isaScalar::deinterleave(in, pixelCount, planes);
+}
+
+void deinterleave(const rgb* in, std::size_t pixelCount, PlanarImage& planes)
+{
+    if(useAVX2())
+        isaAVX2::deinterleave(in, pixelCount, planes);
+    else
+        isaScalar::deinterleave(in, pixelCount, planes);
+}
+
+void interleave(const PlanarImage& planes, std::size_t pixelCount, Color* out)
+{
+    if(useAVX2())
+        isaAVX2::interleave(planes, pixelCount, out);
+    else
+        isaScalar::interleave(planes, pixelCount, out);
+}
+
+void interleave(const PlanarImage& planes, std::size_t pixelCount, rgb* out)
+{
+    if(useAVX2())
+        isaAVX2::interleave(planes, pixelCount, out);
+    else
+        isaScalar::interleave(planes, pixelCount, out);
+}
+
+void floatToHalf(const float* in, unsigned short* out, std::size_t count)
+{
+    if(useAVX2())
+        isaAVX2::floatToHalf(in, out, count);
+    else
+        isaScalar::floatToHalf(in, out, count);
+}
+
+void floatToByte(const float* in, unsigned char* out, std::size_t count)
+{
+    if(useAVX2())
+        isaAVX2::floatToByte(in, out, count);
+    else
+        isaScalar::floatToByte(in, out, count);
+}
+
+void separableConvolve(const float* in, float* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel)
+{
+    if(useAVX2())
+        isaAVX2::separableConvolve(in, out, width, height, nchannels, hKernel, vKernel);
+    else
+        isaScalar::separableConvolve(in, out, width, height, nchannels, hKernel, vKernel);
+}
+
+void separableConvolve(const unsigned char* in, unsigned char* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel)
+{
+    if(useAVX2())
+        isaAVX2::separableConvolve(in, out, width, height, nchannels, hKernel, vKernel);
+    else
+        isaScalar::separableConvolve(in, out, width, height, nchannels, hKernel, vKernel);
+}
+
+void resizeBox(const float* in, float* out, int width, int height, int nchannels, int factor)
+{
+    if(useAVX2())
+        isaAVX2::resizeBox(in, out, width, height, nchannels, factor);
+    else
+        isaScalar::resizeBox(in, out, width, height, nchannels, factor);
+}
+
+void resizeBox(const unsigned char* in, unsigned char* out, int width, int height, int nchannels, int factor)
+{
+    if(useAVX2())
+        isaAVX2::resizeBox(in, out, width, height, nchannels, factor);
+    else
+        isaScalar::resizeBox(in, out, width, height, nchannels, factor);
+}
+
+std::vector<float> gaussianKernel1D(float width)
+{
+    // mimic OIIO's FilterGaussian1D sampled at integer offsets:
+    // g(x) = exp(-2 * (2x / width)^2) for |2x / width| < 1
+    int tapCount = std::max(1, int(std::ceil(width)));
+    tapCount |= 1; // round up to odd, like make_kernel
+    const int radius = tapCount / 2;
+
+    std::vector<float> taps(tapCount);
+    float sum = 0.f;
+    for(int i = 0; i < tapCount; ++i)
+    {
+        const float x = 2.f * float(i - radius) / width;
+        taps[i] = (std::fabs(x) < 1.f) ? std::exp(-2.f * x * x) : 0.f;
+        sum += taps[i];
+    }
+    for(int i = 0; i < tapCount; ++i)
+        taps[i] /= sum;
+    return taps;
+}
+
+#endif // !ALICEVISION_IMAGESIMD_BUILD_AVX2
+
+} // namespace imageSimd
+} // namespace aliceVision
@@ -0,0 +1,216 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace aliceVision {
+
+class rgb;
+class Color;
+
+namespace imageSimd {
+
+/**
+ * @brief Fused RGB(A) to luminance conversion (Rec709 primaries, linear scale).
+ *
+ * Reads interleaved float pixels and writes the weighted sum
+ * R * 0.2126 + G * 0.7152 + B * 0.0722 in a single pass over the buffer,
+ * without any intermediate image. Integer outputs are scaled to the full
+ * range of the type and saturated, like an OIIO format conversion.
+ *
+ * @param[in] in The input interleaved float buffer
+ * @param[in] inChannels The input channel count (>= 3, extra channels are ignored)
+ * @param[in] pixelCount The number of pixels to convert
+ * @param[out] out The output single channel buffer
+ */
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, float* out);
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned char* out);
+void rgbToLuminance(const float* in, int inChannels, std::size_t pixelCount, unsigned short* out);
+
+/**
+ * @brief Broadcast a single channel float image to an interleaved RGB buffer.
+ *
+ * Each input sample is read once and stored in the first three output
+ * channels directly (remaining channels, if any, are set to zero), without
+ * any intermediate image. Integer outputs are scaled and saturated, like an
+ * OIIO format conversion.
+ *
+ * @param[in] in The input single channel float buffer
+ * @param[in] pixelCount The number of pixels to convert
+ * @param[out] out The output interleaved buffer
+ * @param[in] outChannels The output channel count (>= 3)
+ */
+void luminanceToRGB(const float* in, std::size_t pixelCount, float* out, int outChannels);
+void luminanceToRGB(const float* in, std::size_t pixelCount, unsigned char* out, int outChannels);
+
+/**
+ * @brief Out-of-place image transpose: out[x * height + y] = in[y * width + x].
+ *
+ * The loops are cache-blocked on tiles so that both the read and the write
+ * side stay cache-line friendly; the single channel 8-bit and float cases
+ * additionally use an in-register SIMD tile transpose.
+ *
+ * @param[in] in The input image buffer (width x height)
+ * @param[out] out The output image buffer (height x width), must not alias @p in
+ * @param[in] width The input image width
+ * @param[in] height The input image height
+ */
+void transpose(const unsigned char* in, unsigned char* out, int width, int height);
+void transpose(const float* in, float* out, int width, int height);
+void transpose(const rgb* in, rgb* out, int width, int height);
+void transpose(const Color* in, Color* out, int width, int height);
+
+/**
+ * @brief Build a normalized 1-D Gaussian kernel matching OIIO's "gaussian"
+ * filter of the same width (the corresponding 2-D kernel is the outer
+ * product of two 1-D tap sets).
+ *
+ * @param[in] width The kernel width (rounded up to the next odd integer)
+ * @return the normalized taps, of odd size
+ */
+std::vector<float> gaussianKernel1D(float width);
+
+/**
+ * @brief Allocator that default-initializes (rather than value-initializes)
+ * on resize: a buffer of trivial samples grows without the zeroing pass that
+ * an immediately following full overwrite would make pointless.
+ */
+template<typename T>
+struct DefaultInitAllocator : std::allocator<T>
+{
+    template<typename U>
+    struct rebind
+    {
+        typedef DefaultInitAllocator<U> other;
+    };
+
+    DefaultInitAllocator() {}
+
+    template<typename U>
+    DefaultInitAllocator(const DefaultInitAllocator<U>&) {}
+
+    template<typename U>
+    void construct(U* p)
+    {
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    template<typename U, typename A0, typename... Args>
+    void construct(U* p, A0&& a0, Args&&... args)
+    {
+        ::new(static_cast<void*>(p)) U(std::forward<A0>(a0), std::forward<Args>(args)...);
+    }
+};
+
+/**
+ * @brief Planar (SoA) staging of a 3-channel image: one contiguous float
+ * plane per channel, so that single channel kernels can run on each plane
+ * with unit stride and no shuffles.
+ */
+struct PlanarImage
+{
+    std::vector<float, DefaultInitAllocator<float>> r, g, b;
+
+    void resize(std::size_t pixelCount)
+    {
+        r.resize(pixelCount);
+        g.resize(pixelCount);
+        b.resize(pixelCount);
+    }
+};
+
+/**
+ * @brief Deinterleave a 3-channel image into planar float channels.
+ * 8-bit samples are widened to float (not rescaled).
+ *
+ * @param[in] in The input interleaved buffer
+ * @param[in] pixelCount The number of pixels
+ * @param[out] planes The output planes, resized to @p pixelCount
+ */
+void deinterleave(const Color* in, std::size_t pixelCount, PlanarImage& planes);
+void deinterleave(const rgb* in, std::size_t pixelCount, PlanarImage& planes);
+
+/**
+ * @brief Re-interleave planar float channels into a 3-channel image.
+ * 8-bit samples are rounded and saturated.
+ *
+ * @param[in] planes The input planes, of size @p pixelCount each
+ * @param[in] pixelCount The number of pixels
+ * @param[out] out The output interleaved buffer
+ */
+void interleave(const PlanarImage& planes, std::size_t pixelCount, Color* out);
+void interleave(const PlanarImage& planes, std::size_t pixelCount, rgb* out);
+
+/**
+ * @brief Convert a float buffer to IEEE binary16 (half) with round to
+ * nearest even, 8 values per instruction with F16C when available. Values
+ * beyond the largest finite half saturate to +-65504 instead of overflowing
+ * to inf; nan payloads pass through.
+ *
+ * @param[in] in The input float buffer
+ * @param[out] out The output half buffer (raw bit patterns)
+ * @param[in] count The number of values to convert
+ */
+void floatToHalf(const float* in, unsigned short* out, std::size_t count);
+
+/**
+ * @brief Quantize normalized float samples to 8-bit: v * 255, rounded to
+ * nearest and saturated to [0;255], 32 output bytes per iteration with AVX2.
+ *
+ * @param[in] in The input float buffer
+ * @param[out] out The output 8-bit buffer
+ * @param[in] count The number of samples to convert
+ */
+void floatToByte(const float* in, unsigned char* out, std::size_t count);
+
+/**
+ * @brief Separable 2-D convolution: a horizontal pass with @p hKernel
+ * followed by a vertical pass with @p vKernel.
+ *
+ * Samples outside the image are treated as black, like
+ * ImageBufAlgo::convolve. 8-bit pixels are accumulated in float and
+ * rounded/saturated on store. The two passes are fused over cache-resident
+ * row strips, so the horizontal result never round-trips through memory;
+ * as a consequence @p out must not alias @p in.
+ *
+ * @param[in] in The input interleaved buffer
+ * @param[out] out The output interleaved buffer, must not alias @p in
+ * @param[in] width The image width
+ * @param[in] height The image height
+ * @param[in] nchannels The channel count
+ * @param[in] hKernel The normalized horizontal taps, of odd size
+ * @param[in] vKernel The normalized vertical taps, of odd size
+ */
+void separableConvolve(const float* in, float* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel);
+void separableConvolve(const unsigned char* in, unsigned char* out, int width, int height, int nchannels,
+                       const std::vector<float>& hKernel, const std::vector<float>& vKernel);
+
+/**
+ * @brief Integer box-average downscale: each output pixel is the plain
+ * average of the corresponding factor x factor input block.
+ *
+ * The output is (width / factor) x (height / factor); trailing input
+ * rows/columns that do not fill a block are dropped. 8-bit pixels are
+ * accumulated in float and rounded/saturated on store.
+ *
+ * @param[in] in The input interleaved buffer
+ * @param[out] out The output interleaved buffer, must not alias @p in
+ * @param[in] width The input image width
+ * @param[in] height The input image height
+ * @param[in] nchannels The channel count
+ * @param[in] factor The downscale factor (>= 2)
+ */
+void resizeBox(const float* in, float* out, int width, int height, int nchannels, int factor);
+void resizeBox(const unsigned char* in, unsigned char* out, int width, int height, int nchannels, int factor);
+
+} // namespace imageSimd
+} // namespace aliceVision
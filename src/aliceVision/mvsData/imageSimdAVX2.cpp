@@ -0,0 +1,11 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+// AVX2 compilation pass over the imageSimd kernels: this file is built with
+// -mavx2 -mfma -mf16c and provides the imageSimd::isaAVX2 variants selected
+// at runtime by the dispatchers at the end of imageSimd.cpp.
+#define ALICEVISION_IMAGESIMD_BUILD_AVX2 1
+#include "imageSimd.cpp"
@@ -0,0 +1,305 @@
+// This file is part of the AliceVision project.
+// Copyright (c) 2017 AliceVision contributors.
+// This Source Code Form is subject to the terms of the Mozilla Public License,
+// v. 2.0. If a copy of the MPL was not distributed with this file,
+// You can obtain one at https://mozilla.org/MPL/2.0/.
+
+#include <aliceVision/mvsData/imageSimd.hpp>
+#include <aliceVision/mvsData/Color.hpp>
+#include <aliceVision/mvsData/Rgb.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <random>
+#include <vector>
+
+#define BOOST_TEST_MODULE imageSimd
+
+#include <boost/test/unit_test.hpp>
+#include <boost/test/tools/floating_point_comparison.hpp>
+
+using namespace aliceVision;
+
+namespace {
+
+// Rec709 luminance, scalar reference
+float lumaRef(const float* pixel)
+{
+    return pixel[0] * .2126f + pixel[1] * .7152f + pixel[2] * .0722f;
+}
+
+// quantization reference: scale, round to nearest, saturate
+template<typename T>
+T quantizeRef(float v, float scale)
+{
+    const double scaled = double(v) * scale;
+    if(!(scaled > 0.0)) // also catches nan
+        return 0;
+    if(scaled >= scale)
+        return T(scale);
+    return T(std::lround(scaled));
+}
+
+std::vector<float> randomBuffer(std::size_t count, float lo, float hi, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> dist(lo, hi);
+    std::vector<float> buffer(count);
+    for(float& v : buffer)
+        v = dist(gen);
+    return buffer;
+}
+
+// dense zero-padded 2-D convolution reference, accumulated in double
+std::vector<float> convolveRef(const std::vector<float>& in, int width, int height, int nchannels,
+                               const std::vector<float>& hKernel, const std::vector<float>& vKernel)
+{
+    const int hRadius = int(hKernel.size()) / 2;
+    const int vRadius = int(vKernel.size()) / 2;
+    std::vector<float> out(in.size());
+    for(int y = 0; y < height; ++y)
+    for(int x = 0; x < width; ++x)
+    for(int c = 0; c < nchannels; ++c)
+    {
+        double sum = 0.0;
+        for(int j = 0; j < int(vKernel.size()); ++j)
+        for(int i = 0; i < int(hKernel.size()); ++i)
+        {
+            const int sx = x + i - hRadius;
+            const int sy = y + j - vRadius;
+            if(sx < 0 || sx >= width || sy < 0 || sy >= height)
+                continue;
+            sum += double(vKernel[j]) * double(hKernel[i]) * double(in[(std::size_t(sy) * width + sx) * nchannels + c]);
+        }
+        out[(std::size_t(y) * width + x) * nchannels + c] = float(sum);
+    }
+    return out;
+}
+
+} // namespace
+
+// The quantizers must saturate out-of-range and infinite values to full scale
+// instead of wrapping in the float to int32 conversion, in the vector body and
+// in the scalar tail alike.
+BOOST_AUTO_TEST_CASE(imageSimd_quantizerSaturation)
+{
+    const float inf = std::numeric_limits<float>::infinity();
+    const std::size_t count = 71; // vector body + a scalar tail
+
+    std::vector<float> luma(count, 1e8f);
+    luma[1] = 0.25f;
+    luma[2] = -3.0f;
+    luma[40] = inf;
+    luma[count - 2] = inf; // in the tail
+
+    std::vector<float> rgbIn(count * 3);
+    for(std::size_t i = 0; i < count; ++i)
+        rgbIn[i * 3 + 0] = rgbIn[i * 3 + 1] = rgbIn[i * 3 + 2] = luma[i];
+
+    std::vector<unsigned char> u8(count, 7);
+    std::vector<unsigned short> u16(count, 7);
+    std::vector<unsigned char> bytes(count, 7);
+    std::vector<unsigned char> rgb8(count * 3, 7);
+
+    imageSimd::rgbToLuminance(rgbIn.data(), 3, count, u8.data());
+    imageSimd::rgbToLuminance(rgbIn.data(), 3, count, u16.data());
+    imageSimd::floatToByte(luma.data(), bytes.data(), count);
+    imageSimd::luminanceToRGB(luma.data(), count, rgb8.data(), 3);
+
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        const unsigned char e8 = (i == 1) ? 64 : (i == 2) ? 0 : 255;
+        const unsigned short e16 = (i == 1) ? 16384 : (i == 2) ? 0 : 65535;
+        BOOST_CHECK_EQUAL(int(u8[i]), int(e8));
+        BOOST_CHECK_EQUAL(int(u16[i]), int(e16));
+        BOOST_CHECK_EQUAL(int(bytes[i]), int(e8));
+        for(int c = 0; c < 3; ++c)
+            BOOST_CHECK_EQUAL(int(rgb8[i * 3 + c]), int(e8));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(imageSimd_luminanceMatchesScalarReference)
+{
+    const std::size_t count = 1023; // not a multiple of the vector width
+    const std::vector<float> in = randomBuffer(count * 4, -0.2f, 1.2f, 42);
+
+    for(int inChannels = 3; inChannels <= 4; ++inChannels)
+    {
+        std::vector<float> outF(count);
+        std::vector<unsigned char> outU8(count);
+        std::vector<unsigned short> outU16(count);
+        imageSimd::rgbToLuminance(in.data(), inChannels, count, outF.data());
+        imageSimd::rgbToLuminance(in.data(), inChannels, count, outU8.data());
+        imageSimd::rgbToLuminance(in.data(), inChannels, count, outU16.data());
+
+        for(std::size_t i = 0; i < count; ++i)
+        {
+            const float ref = lumaRef(in.data() + i * inChannels);
+            BOOST_CHECK_SMALL(outF[i] - ref, 1e-5f);
+            // the fused multiply-adds may round to the neighbouring level
+            BOOST_CHECK_LE(std::abs(int(outU8[i]) - int(quantizeRef<unsigned char>(ref, 255.0f))), 1);
+            BOOST_CHECK_LE(std::abs(int(outU16[i]) - int(quantizeRef<unsigned short>(ref, 65535.0f))), 1);
+        }
+    }
+}
+
+// floatToHalf must saturate to the largest finite half instead of overflowing
+// to inf, and keep nan as nan.
+BOOST_AUTO_TEST_CASE(imageSimd_floatToHalfSaturation)
+{
+    const std::size_t count = 19; // vector body + a scalar tail
+    std::vector<float> in(count, 1e6f);
+    in[1] = 1.0f;
+    in[2] = 0.5f;
+    in[3] = -1e6f;
+    in[4] = std::numeric_limits<float>::infinity();
+    in[5] = std::numeric_limits<float>::quiet_NaN();
+    in[count - 1] = 1e6f;
+
+    std::vector<unsigned short> out(count, 0);
+    imageSimd::floatToHalf(in.data(), out.data(), count);
+
+    BOOST_CHECK_EQUAL(out[1], 0x3C00); // 1.0
+    BOOST_CHECK_EQUAL(out[2], 0x3800); // 0.5
+    BOOST_CHECK_EQUAL(out[3], 0xFBFF); // -65504, largest finite magnitude
+    // nan keeps an all-ones exponent and a non-zero mantissa
+    BOOST_CHECK_EQUAL(out[5] & 0x7C00, 0x7C00);
+    BOOST_CHECK_NE(out[5] & 0x03FF, 0);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        if(i >= 1 && i <= 3)
+            continue;
+        BOOST_CHECK_EQUAL(out[i] & 0x7FFF, (i == 5) ? (out[5] & 0x7FFF) : 0x7BFF); // +-65504, never inf
+    }
+}
+
+// The fused passes are computed over row strips; the result must not depend on
+// where the strip boundaries fall, so test heights below, at and across the
+// strip size against a dense 2-D reference.
+BOOST_AUTO_TEST_CASE(imageSimd_separableConvolveStripBoundaries)
+{
+    const std::vector<float> hKernel = imageSimd::gaussianKernel1D(5.0f);
+    const std::vector<float> vKernel = imageSimd::gaussianKernel1D(3.0f);
+    const int heights[] = {1, 7, 63, 64, 65, 130};
+    const int width = 37;
+
+    for(const int height : heights)
+    {
+        for(int nchannels = 1; nchannels <= 3; nchannels += 2)
+        {
+            const std::size_t size = std::size_t(width) * height * nchannels;
+            const std::vector<float> in = randomBuffer(size, 0.f, 1.f, 1000u + height);
+            const std::vector<float> ref = convolveRef(in, width, height, nchannels, hKernel, vKernel);
+
+            std::vector<float> out(size, -1.f);
+            imageSimd::separableConvolve(in.data(), out.data(), width, height, nchannels, hKernel, vKernel);
+            for(std::size_t i = 0; i < size; ++i)
+                BOOST_CHECK_SMALL(out[i] - ref[i], 1e-4f);
+
+            std::vector<unsigned char> in8(size);
+            for(std::size_t i = 0; i < size; ++i)
+                in8[i] = static_cast<unsigned char>(std::lround(in[i] * 255.f));
+            std::vector<float> in8f(size);
+            for(std::size_t i = 0; i < size; ++i)
+                in8f[i] = float(in8[i]);
+            const std::vector<float> ref8 = convolveRef(in8f, width, height, nchannels, hKernel, vKernel);
+
+            std::vector<unsigned char> out8(size, 7);
+            imageSimd::separableConvolve(in8.data(), out8.data(), width, height, nchannels, hKernel, vKernel);
+            for(std::size_t i = 0; i < size; ++i)
+                BOOST_CHECK_LE(std::abs(int(out8[i]) - int(std::lround(ref8[i]))), 1);
+        }
+    }
+}
+
+// The transpose kernels are tiled; check shapes whose edges do not fill a
+// whole tile, plus exact tile multiples.
+BOOST_AUTO_TEST_CASE(imageSimd_transposeTails)
+{
+    const int shapes[][2] = {{1, 1}, {8, 8}, {16, 16}, {13, 9}, {37, 21}, {64, 5}};
+
+    for(const auto& shape : shapes)
+    {
+        const int width = shape[0];
+        const int height = shape[1];
+        const std::size_t size = std::size_t(width) * height;
+
+        std::vector<float> inF(size);
+        std::vector<unsigned char> in8(size);
+        std::vector<rgb> inRGB(size);
+        std::vector<Color> inColor(size);
+        for(std::size_t i = 0; i < size; ++i)
+        {
+            inF[i] = float(i);
+            in8[i] = static_cast<unsigned char>(i * 31u);
+            inRGB[i] = rgb(static_cast<unsigned char>(i), static_cast<unsigned char>(i * 3u), static_cast<unsigned char>(i * 7u));
+            inColor[i] = Color(float(i), float(i) + 0.25f, float(i) + 0.5f);
+        }
+
+        std::vector<float> outF(size);
+        std::vector<unsigned char> out8(size);
+        std::vector<rgb> outRGB(size);
+        std::vector<Color> outColor(size);
+        imageSimd::transpose(inF.data(), outF.data(), width, height);
+        imageSimd::transpose(in8.data(), out8.data(), width, height);
+        imageSimd::transpose(inRGB.data(), outRGB.data(), width, height);
+        imageSimd::transpose(inColor.data(), outColor.data(), width, height);
+
+        for(int y = 0; y < height; ++y)
+        for(int x = 0; x < width; ++x)
+        {
+            const std::size_t src = std::size_t(y) * width + x;
+            const std::size_t dst = std::size_t(x) * height + y;
+            BOOST_CHECK_EQUAL(outF[dst], inF[src]);
+            BOOST_CHECK_EQUAL(int(out8[dst]), int(in8[src]));
+            BOOST_CHECK(outRGB[dst].r == inRGB[src].r && outRGB[dst].g == inRGB[src].g && outRGB[dst].b == inRGB[src].b);
+            BOOST_CHECK_EQUAL(outColor[dst].r, inColor[src].r);
+            BOOST_CHECK_EQUAL(outColor[dst].g, inColor[src].g);
+            BOOST_CHECK_EQUAL(outColor[dst].b, inColor[src].b);
+        }
+    }
+}
+
+// Deinterleave/interleave round trips, with a pixel count that leaves a
+// scalar tail after the 8-pixel vector body.
+BOOST_AUTO_TEST_CASE(imageSimd_interleaveRoundTrip)
+{
+    const std::size_t count = 29;
+
+    std::vector<Color> colors(count);
+    std::vector<rgb> rgbs(count);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        colors[i] = Color(float(i) * 0.125f, float(i) * 0.25f + 0.5f, float(i) * 0.0625f - 1.f);
+        rgbs[i] = rgb(static_cast<unsigned char>(i * 9u), static_cast<unsigned char>(i * 5u), static_cast<unsigned char>(255u - i));
+    }
+
+    imageSimd::PlanarImage planes;
+    imageSimd::deinterleave(colors.data(), count, planes);
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        BOOST_CHECK_EQUAL(planes.r[i], colors[i].r);
+        BOOST_CHECK_EQUAL(planes.g[i], colors[i].g);
+        BOOST_CHECK_EQUAL(planes.b[i], colors[i].b);
+    }
+
+    std::vector<Color> colorsBack(count);
+    imageSimd::interleave(planes, count, colorsBack.data());
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        BOOST_CHECK_EQUAL(colorsBack[i].r, colors[i].r);
+        BOOST_CHECK_EQUAL(colorsBack[i].g, colors[i].g);
+        BOOST_CHECK_EQUAL(colorsBack[i].b, colors[i].b);
+    }
+
+    imageSimd::deinterleave(rgbs.data(), count, planes);
+    std::vector<rgb> rgbsBack(count);
+    imageSimd::interleave(planes, count, rgbsBack.data());
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        BOOST_CHECK_EQUAL(int(planes.r[i]), int(rgbs[i].r)); // widened, not rescaled
+        BOOST_CHECK(rgbsBack[i].r == rgbs[i].r && rgbsBack[i].g == rgbs[i].g && rgbsBack[i].b == rgbs[i].b);
+    }
+}